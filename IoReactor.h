@@ -0,0 +1,409 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <unistd.h>
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define IOREACTOR_HAS_IO_URING 1
+#endif
+
+// Completion-based reads and writes for the thread pool. Operations are queued with a callback and
+// reaped by poll(), which never blocks, so workers can service I/O between tasks instead of
+// stalling on it. io_uring is used when the kernel allows it; otherwise readiness is tracked with
+// epoll and the operation is performed once the descriptor is ready; pollable descriptors are put
+// in non-blocking mode while they have operations waiting, and get their flags back once the last
+// one completes. Regular files cannot be polled, so on the epoll backend they are read or written
+// directly at submission. Failures to queue an operation are reported through its completion.
+class IoReactor {
+public:
+    using Completion = std::function<void(ssize_t)>;  // Bytes transferred, or -errno
+
+    enum class Backend { IoUring, Epoll };
+
+    explicit IoReactor(Backend preferred = Backend::IoUring, unsigned entries = 256) {
+#ifdef IOREACTOR_HAS_IO_URING
+        if (preferred == Backend::IoUring && setupIoUring(entries)) {
+            kind = Backend::IoUring;
+            return;
+        }
+#endif
+        (void)preferred;
+        (void)entries;
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd < 0) {
+            throw std::system_error(errno, std::generic_category(), "epoll_create1");
+        }
+        kind = Backend::Epoll;
+    }
+
+    IoReactor(const IoReactor&) = delete;
+    IoReactor& operator=(const IoReactor&) = delete;
+
+    // All operations must have completed: the kernel may still write into their buffers
+    ~IoReactor() {
+#ifdef IOREACTOR_HAS_IO_URING
+        if (ringFd >= 0) {
+            munmap(sqes, sqesSize);
+            if (cqRing != sqRing) {
+                munmap(cqRing, cqRingSize);
+            }
+            munmap(sqRing, sqRingSize);
+            close(ringFd);
+        }
+#endif
+        if (epollFd >= 0) {
+            close(epollFd);
+        }
+    }
+
+    Backend backend() const { return kind; }
+
+    // Number of submitted operations whose completion has not been delivered yet
+    size_t pending() const { return inFlight.load(std::memory_order_acquire); }
+
+    // An offset of -1 uses (and advances) the file position, as read(2)/write(2) would
+    void read(int fd, void* buf, size_t len, off_t offset, Completion done) {
+        submit(Op{fd, buf, len, offset, false, std::move(done)});
+    }
+
+    void write(int fd, const void* buf, size_t len, off_t offset, Completion done) {
+        submit(Op{fd, const_cast<void*>(buf), len, offset, true, std::move(done)});
+    }
+
+    // Reap finished operations and run their callbacks. Only one thread polls at a time; others
+    // return 0 immediately. Returns the number of callbacks run.
+    size_t poll() {
+        if (polling.exchange(true, std::memory_order_acquire)) {
+            return 0;
+        }
+        std::vector<std::pair<Completion, ssize_t>> ready;
+#ifdef IOREACTOR_HAS_IO_URING
+        if (kind == Backend::IoUring) {
+            reapIoUring(ready);
+        } else
+#endif
+        {
+            reapEpoll(ready);
+        }
+        polling.store(false, std::memory_order_release);
+
+        for (auto& [done, res] : ready) {
+            done(res);
+            inFlight.fetch_sub(1, std::memory_order_acq_rel);  // After done() so pending() covers it
+        }
+        return ready.size();
+    }
+
+private:
+    struct Op {
+        int fd;
+        void* buf;
+        size_t len;
+        off_t offset;
+        bool isWrite;
+        Completion done;
+    };
+
+    Backend kind = Backend::Epoll;
+    std::atomic<size_t> inFlight{0};
+    std::atomic<bool> polling{false};
+
+    // Reads return what is available, like read(2). Writes keep going until everything is written
+    // or a non-blocking fd fills up, and then report the partial count.
+    static ssize_t perform(const Op& op) {
+        if (!op.isWrite) {
+            ssize_t r = op.offset < 0 ? ::read(op.fd, op.buf, op.len) : ::pread(op.fd, op.buf, op.len, op.offset);
+            return r < 0 ? -errno : r;
+        }
+
+        size_t done = 0;
+        while (done < op.len) {
+            const char* p = static_cast<const char*>(op.buf) + done;
+            ssize_t r = op.offset < 0 ? ::write(op.fd, p, op.len - done)
+                                      : ::pwrite(op.fd, p, op.len - done, op.offset + static_cast<off_t>(done));
+            if (r < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return done > 0 ? static_cast<ssize_t>(done) : -errno;
+            }
+            if (r == 0) {
+                break;
+            }
+            done += static_cast<size_t>(r);
+        }
+        return static_cast<ssize_t>(done);
+    }
+
+    void submit(Op op) {
+        inFlight.fetch_add(1, std::memory_order_acq_rel);
+#ifdef IOREACTOR_HAS_IO_URING
+        if (kind == Backend::IoUring) {
+            submitIoUring(std::move(op));
+            return;
+        }
+#endif
+        submitEpoll(std::move(op));
+    }
+
+    // --- epoll backend ---
+
+    struct FdOps {
+        std::deque<Op> ops;
+        bool registered = false;
+        int savedFlags = -1;  // File status flags to restore on removal, if we changed them
+    };
+
+    int epollFd = -1;
+    std::mutex epollMutex;
+    std::unordered_map<int, FdOps> waiting;
+
+    void submitEpoll(Op op) {
+        std::unique_lock<std::mutex> lock(epollMutex);
+        FdOps& entry = waiting[op.fd];
+        entry.ops.push_back(std::move(op));
+        if (int err = arm(entry.ops.back().fd, entry)) {
+            // Not pollable (regular file): always ready, so do it now. Anything else is a failure.
+            Op now = std::move(entry.ops.back());
+            entry.ops.pop_back();
+            if (entry.ops.empty() && !entry.registered) {
+                waiting.erase(now.fd);
+            }
+            lock.unlock();
+            now.done(err == EPERM ? perform(now) : -err);
+            inFlight.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    // (Re-)register interest in every direction that has a waiting op. Caller holds epollMutex.
+    // Returns 0 or the epoll_ctl errno; EPERM means the fd cannot be polled.
+    int arm(int fd, FdOps& entry) {
+        epoll_event ev{};
+        ev.data.fd = fd;
+        ev.events = EPOLLONESHOT;
+        for (auto& op : entry.ops) {
+            ev.events |= op.isWrite ? EPOLLOUT : EPOLLIN;
+        }
+        if (epoll_ctl(epollFd, entry.registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev) == 0) {
+            if (!entry.registered) {
+                // Readiness only promises some data or space; a blocking fd could still stall the
+                // poller on a large transfer, so pollable fds are switched to non-blocking mode
+                int flags = fcntl(fd, F_GETFL);
+                if (flags >= 0 && !(flags & O_NONBLOCK) && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0) {
+                    entry.savedFlags = flags;
+                }
+            }
+            entry.registered = true;
+            return 0;
+        }
+        return errno;
+    }
+
+    // Stop watching an fd with nothing left to do. Caller holds epollMutex.
+    void forget(int fd, FdOps& entry) {
+        if (entry.registered) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        }
+        if (entry.savedFlags >= 0) {
+            fcntl(fd, F_SETFL, entry.savedFlags);
+        }
+        waiting.erase(fd);
+    }
+
+    void reapEpoll(std::vector<std::pair<Completion, ssize_t>>& ready) {
+        epoll_event events[64];
+        int n = epoll_wait(epollFd, events, 64, 0);
+        for (int i = 0; i < n; ++i) {
+            int fd = events[i].data.fd;
+            bool failed = events[i].events & (EPOLLERR | EPOLLHUP);
+            bool canRead = failed || (events[i].events & EPOLLIN);
+            bool canWrite = failed || (events[i].events & EPOLLOUT);
+
+            // Take the first op of each ready direction out, then do the syscalls unlocked
+            std::vector<Op> attempt;
+            {
+                std::lock_guard<std::mutex> lock(epollMutex);
+                auto it = waiting.find(fd);
+                if (it == waiting.end()) {
+                    continue;
+                }
+                auto& ops = it->second.ops;
+                for (auto op = ops.begin(); op != ops.end() && (canRead || canWrite);) {
+                    bool& allowed = op->isWrite ? canWrite : canRead;
+                    if (!allowed) {
+                        ++op;
+                        continue;
+                    }
+                    allowed = false;
+                    attempt.push_back(std::move(*op));
+                    op = ops.erase(op);
+                }
+            }
+
+            std::vector<Op> retry;
+            for (auto& op : attempt) {
+                ssize_t res = perform(op);
+                if (res == -EAGAIN || res == -EWOULDBLOCK) {
+                    retry.push_back(std::move(op));
+                } else {
+                    ready.emplace_back(std::move(op.done), res);
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(epollMutex);
+            FdOps& entry = waiting[fd];
+            for (auto op = retry.rbegin(); op != retry.rend(); ++op) {
+                entry.ops.push_front(std::move(*op));  // Keep their place ahead of later submissions
+            }
+            if (!entry.ops.empty()) {
+                if (int err = arm(fd, entry)) {
+                    // Cannot wait on the fd any more: fail what is left rather than strand it
+                    for (auto& op : entry.ops) {
+                        ready.emplace_back(std::move(op.done), -err);
+                    }
+                    entry.ops.clear();
+                }
+            }
+            if (entry.ops.empty()) {
+                forget(fd, entry);
+            }
+        }
+    }
+
+#ifdef IOREACTOR_HAS_IO_URING
+    // --- io_uring backend (raw syscalls, no liburing dependency) ---
+
+    int ringFd = -1;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqRingSize = 0, cqRingSize = 0, sqesSize = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned cqEntries = 0;
+    std::mutex sqMutex;
+
+    // Ring indices are shared with the kernel; plain fields accessed like liburing's io_uring_smp_*
+    static unsigned loadAcquire(const unsigned* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+    static void storeRelease(unsigned* p, unsigned v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+    bool setupIoUring(unsigned entries) {
+        io_uring_params p{};
+        int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &p));
+        if (fd < 0) {
+            return false;  // ENOSYS, or blocked by seccomp/sysctl: fall back to epoll
+        }
+
+        sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single = p.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        }
+
+        sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        cqRing = single ? sqRing
+                        : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        sqesSize = p.sq_entries * sizeof(io_uring_sqe);
+        void* sqeMem = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqeMem == MAP_FAILED) {
+            if (sqeMem != MAP_FAILED) munmap(sqeMem, sqesSize);
+            if (cqRing != MAP_FAILED && cqRing != sqRing) munmap(cqRing, cqRingSize);
+            if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+            close(fd);
+            return false;
+        }
+
+        auto* sq = static_cast<char*>(sqRing);
+        auto* cq = static_cast<char*>(cqRing);
+        sqHead = reinterpret_cast<unsigned*>(sq + p.sq_off.head);
+        sqTail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+        cqHead = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+        cqTail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + p.cq_off.cqes);
+        sqes = static_cast<io_uring_sqe*>(sqeMem);
+        cqEntries = p.cq_entries;
+        ringFd = fd;
+        return true;
+    }
+
+    void submitIoUring(Op op) {
+        // Keep completions within the CQ ring so none are dropped or deferred
+        while (pending() > cqEntries) {
+            poll();
+            std::this_thread::yield();
+        }
+
+        auto* owned = new Op(std::move(op));
+        std::unique_lock<std::mutex> lock(sqMutex);
+
+        unsigned tail = *sqTail;  // Only we write the SQ tail
+        unsigned idx = tail & *sqMask;
+        io_uring_sqe& sqe = sqes[idx];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = owned->isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+        sqe.fd = owned->fd;
+        sqe.addr = reinterpret_cast<unsigned long long>(owned->buf);
+        sqe.len = static_cast<unsigned>(owned->len);
+        sqe.off = static_cast<unsigned long long>(owned->offset);  // -1 = current file position
+        sqe.user_data = reinterpret_cast<unsigned long long>(owned);
+        sqArray[idx] = idx;
+        storeRelease(sqTail, tail + 1);
+
+        // We submit one entry at a time, so the SQ never holds more than this one
+        long r;
+        do {
+            r = syscall(__NR_io_uring_enter, ringFd, 1, 0, 0, nullptr, 0);
+        } while (r < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY));
+        if (r >= 0 || loadAcquire(sqHead) != tail) {
+            return;  // Consumed: the kernel posts a completion, even if it is an error
+        }
+
+        // The kernel refused the entry outright: take it back and report the error
+        int err = errno;
+        storeRelease(sqTail, tail);
+        lock.unlock();
+        Completion done = std::move(owned->done);
+        delete owned;
+        done(-err);
+        inFlight.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void reapIoUring(std::vector<std::pair<Completion, ssize_t>>& ready) {
+        unsigned head = *cqHead;  // Only we write the CQ head
+        unsigned tail = loadAcquire(cqTail);
+        for (; head != tail; ++head) {
+            io_uring_cqe& cqe = cqes[head & *cqMask];
+            auto* op = reinterpret_cast<Op*>(cqe.user_data);
+            ready.emplace_back(std::move(op->done), cqe.res);
+            delete op;
+        }
+        storeRelease(cqHead, head);
+    }
+#endif
+};
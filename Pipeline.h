@@ -0,0 +1,287 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <exception>
+#include "LockFreeQueue.h"
+#include "ThreadPool.h"
+
+// How a pipeline stage may be executed
+enum class StageMode {
+    SerialInOrder,     // One batch at a time, in the order the source produced them
+    SerialOutOfOrder,  // One batch at a time, in arrival order
+    Parallel           // Any number of batches at once
+};
+
+// Stream processing pipeline on top of the thread pool. A serial source fills items, which travel
+// in batches through a chain of stages; every stage updates the item in place, so the item type
+// carries the fields that each stage reads and writes (e.g. raw line -> parsed record -> total).
+//
+// Batches double as tokens: only `tokenLimit` batches exist, and the source waits for the last
+// stage to retire one before producing more, which bounds memory and provides back-pressure.
+// Serial stages own a bounded inbox (a LockFreeQueue, producer-locked when fed by a parallel
+// stage) drained by at most one pool task at a time. Parallel stages run inline on whichever
+// task carries the batch, so a chain of parallel stages costs no handoff at all.
+template<typename T>
+class Pipeline {
+public:
+    Pipeline(ThreadPool& pool, size_t tokenLimit = 16, size_t batchSize = 64)
+        : pool(pool), tokenLimit(tokenLimit), batchSize(batchSize),
+          freeBatches(channelCapacity(tokenLimit)) {
+        if (tokenLimit == 0 || batchSize == 0) {
+            throw std::runtime_error("Pipeline token limit and batch size must be positive");
+        }
+        batches.reserve(tokenLimit);
+        for (size_t i = 0; i < tokenLimit; ++i) {
+            batches.push_back(std::make_unique<Batch>(batchSize));
+        }
+    }
+
+    Pipeline(const Pipeline&) = delete;
+    Pipeline& operator=(const Pipeline&) = delete;
+
+    // Producer of the stream: fill the item and return true, or return false once exhausted
+    Pipeline& source(std::function<bool(T&)> fn) {
+        sourceFn = std::move(fn);
+        return *this;
+    }
+
+    // Append a stage applied to every item
+    Pipeline& stage(StageMode mode, std::function<void(T&)> fn) {
+        bool multiProducer = !stages.empty() && stages.back()->mode == StageMode::Parallel;
+        stages.push_back(std::make_unique<Stage>(mode, std::move(fn), multiProducer, tokenLimit));
+        return *this;
+    }
+
+    // Run the stream to completion. Blocks the caller, so call it from outside the pool. The first
+    // exception thrown by a stage stops the source and is rethrown here.
+    void run() {
+        if (!sourceFn) {
+            throw std::runtime_error("Pipeline has no source");
+        }
+
+        for (auto& b : batches) {
+            freeBatches.enqueue(b.get());
+        }
+        for (auto& s : stages) {
+            s->nextSeq = 0;
+        }
+        nextSeq = 0;
+        exhausted = false;
+        failed.store(false, std::memory_order_relaxed);
+        error = nullptr;
+        std::promise<void> done;
+        finished = &done;
+
+        // Every free token is one unit of work for the source
+        sourcePending.store(tokenLimit, std::memory_order_relaxed);
+        inFlight.store(1, std::memory_order_relaxed);
+        pool.submit([this]() { drainSource(); });
+
+        done.get_future().wait();
+        finished = nullptr;
+
+        Batch* b = nullptr;
+        while (freeBatches.dequeue(b)) {
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct Batch {
+        std::vector<T> items;
+        size_t count = 0;
+        size_t seq = 0;
+
+        explicit Batch(size_t n) : items(n) {}
+    };
+
+    struct Stage {
+        StageMode mode;
+        std::function<void(T&)> fn;
+        bool multiProducer;                   // Fed by a parallel stage, so pushes take the lock
+        LockFreeQueue<Batch*> inbox;
+        alignas(64) std::atomic<bool> inboxLock{false};
+        alignas(64) std::atomic<size_t> pending{0};  // Batches pushed but not yet taken by the drain
+        std::vector<Batch*> window;           // Reorder buffer indexed by seq % tokenLimit
+        size_t nextSeq = 0;
+
+        Stage(StageMode m, std::function<void(T&)> f, bool mp, size_t tokens)
+            : mode(m), fn(std::move(f)), multiProducer(mp), inbox(channelCapacity(tokens)),
+              window(tokens, nullptr) {}
+    };
+
+    ThreadPool& pool;
+    size_t tokenLimit;
+    size_t batchSize;
+    std::function<bool(T&)> sourceFn;
+    std::vector<std::unique_ptr<Stage>> stages;
+    std::vector<std::unique_ptr<Batch>> batches;
+
+    // Retired tokens, consumed only by the source. Producers always lock: the last stage retires
+    // while the source can hand back an empty batch at the same time.
+    LockFreeQueue<Batch*> freeBatches;
+    std::atomic<bool> freeLock{false};
+
+    alignas(64) std::atomic<size_t> sourcePending{0};
+    alignas(64) std::atomic<size_t> inFlight{0};  // Live batches plus scheduled drain tasks
+    size_t nextSeq = 0;
+    bool exhausted = false;
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::promise<void>* finished = nullptr;
+
+    // Inboxes never fill: at most tokenLimit batches exist and the ring keeps one slot free
+    static size_t channelCapacity(size_t tokens) {
+        size_t cap = 2;
+        while (cap <= tokens) {
+            cap <<= 1;
+        }
+        return cap;
+    }
+
+    static void push(LockFreeQueue<Batch*>& q, std::atomic<bool>& lock, bool locked, Batch* b) {
+        if (locked) {
+            while (lock.exchange(true, std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+        q.enqueue(b);
+        if (locked) {
+            lock.store(false, std::memory_order_release);
+        }
+    }
+
+    void drainSource() {
+        do {
+            if (!exhausted && failed.load(std::memory_order_relaxed)) {
+                exhausted = true;
+            }
+            if (exhausted) {
+                continue;
+            }
+
+            Batch* b = nullptr;
+            bool ok = freeBatches.dequeue(b);  // One free batch per pending unit
+            assert(ok);
+            (void)ok;
+            b->count = 0;
+            try {
+                while (b->count < batchSize && sourceFn(b->items[b->count])) {
+                    ++b->count;
+                }
+            } catch (...) {
+                fail();
+            }
+            if (b->count < batchSize) {
+                exhausted = true;
+            }
+
+            if (b->count == 0) {
+                push(freeBatches, freeLock, true, b);
+                continue;
+            }
+            b->seq = nextSeq++;
+            inFlight.fetch_add(1, std::memory_order_relaxed);
+            forward(b, 0, true);
+        } while (sourcePending.fetch_sub(1, std::memory_order_acq_rel) != 1);
+
+        release();
+    }
+
+    void drainStage(size_t i) {
+        Stage& s = *stages[i];
+        do {
+            Batch* b = nullptr;
+            bool ok = s.inbox.dequeue(b);  // One batch per pending unit
+            assert(ok);
+            (void)ok;
+
+            if (s.mode == StageMode::SerialOutOfOrder) {
+                process(s, b);
+                forward(b, i + 1, true);
+                continue;
+            }
+
+            s.window[b->seq % tokenLimit] = b;
+            while (Batch* ready = s.window[s.nextSeq % tokenLimit]) {
+                s.window[s.nextSeq % tokenLimit] = nullptr;
+                ++s.nextSeq;
+                process(s, ready);
+                forward(ready, i + 1, true);
+            }
+        } while (s.pending.fetch_sub(1, std::memory_order_acq_rel) != 1);
+
+        release();
+    }
+
+    void process(Stage& s, Batch* b) {
+        if (failed.load(std::memory_order_relaxed)) {
+            return;
+        }
+        try {
+            for (size_t k = 0; k < b->count; ++k) {
+                s.fn(b->items[k]);
+            }
+        } catch (...) {
+            fail();
+        }
+    }
+
+    // Hand a batch to stage i. Parallel stages run inline unless the caller is a serial drain,
+    // which must stay free for its next batch.
+    void forward(Batch* b, size_t i, bool fromSerial) {
+        while (i < stages.size() && stages[i]->mode == StageMode::Parallel) {
+            if (fromSerial) {
+                pool.submit([this, b, i]() {
+                    process(*stages[i], b);
+                    forward(b, i + 1, false);
+                });
+                return;
+            }
+            process(*stages[i], b);
+            ++i;
+        }
+
+        if (i == stages.size()) {
+            retire(b);
+            return;
+        }
+
+        Stage& s = *stages[i];
+        push(s.inbox, s.inboxLock, s.multiProducer, b);
+        if (s.pending.fetch_add(1, std::memory_order_acq_rel) == 0) {
+            inFlight.fetch_add(1, std::memory_order_relaxed);
+            pool.submit([this, i]() { drainStage(i); });
+        }
+    }
+
+    // Return the token to the source. The drain is scheduled before our own count is dropped so
+    // the pipeline cannot finish while a task that touches it is still queued.
+    void retire(Batch* b) {
+        push(freeBatches, freeLock, true, b);
+        if (sourcePending.fetch_add(1, std::memory_order_acq_rel) == 0) {
+            inFlight.fetch_add(1, std::memory_order_relaxed);
+            pool.submit([this]() { drainSource(); });
+        }
+        release();
+    }
+
+    void release() {
+        if (inFlight.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            finished->set_value();  // Last touch: run() may return as soon as this is set
+        }
+    }
+
+    void fail() {
+        if (!failed.exchange(true)) {
+            error = std::current_exception();
+        }
+    }
+};
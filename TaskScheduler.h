@@ -5,26 +5,98 @@
 #include <memory>
 #include <future>
 #include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <exception>
+#include <type_traits>
+#include <utility>
 #include "ThreadPool.h"
 
 class TaskGraphScheduler {
 public:
     struct ITaskNode {
-        std::vector<ITaskNode*> dependents;
+        // Intrusive Treiber-style list of dependents. Once the node completes, the head is swapped
+        // for a sealed marker so late dependents can tell that the dependency already finished.
+        struct DependentEdge {
+            ITaskNode* node;
+            DependentEdge* next;
+        };
+
+        std::atomic<DependentEdge*> dependents{nullptr};
         std::atomic<size_t> remainingDeps{0};
+        std::atomic<size_t> pendingChildren{1};  // The node's own body plus every spawned child
+        ITaskNode* parent = nullptr;             // Node that spawned this one, joined on completion
+        std::exception_ptr error;                // First failure of the body or any spawned child
+        std::atomic<bool> failed{false};
+
         virtual void run() = 0;
-        virtual ~ITaskNode() = default;
+        virtual void finish() = 0;  // Publish the result once the body and all children are done
+        virtual ~ITaskNode() {
+            DependentEdge* e = dependents.load(std::memory_order_relaxed);
+            while (e != nullptr && e != sealed()) {
+                delete std::exchange(e, e->next);
+            }
+        }
+
+        // Keep the first exception; children of one parent may fail concurrently
+        void recordError(std::exception_ptr e) {
+            if (!failed.exchange(true, std::memory_order_acq_rel)) {
+                error = std::move(e);
+            }
+        }
+
+        static DependentEdge* sealed() {
+            static DependentEdge marker{nullptr, nullptr};
+            return &marker;
+        }
+
+        // Append a dependent; lock-free and safe against this node completing concurrently.
+        // Returns false if this node has already completed, in which case nothing was recorded.
+        bool addDependent(ITaskNode* dep) {
+            auto* edge = new DependentEdge{dep, dependents.load(std::memory_order_acquire)};
+            while (edge->next != sealed()) {
+                if (dependents.compare_exchange_weak(edge->next, edge,
+                                                     std::memory_order_acq_rel,
+                                                     std::memory_order_acquire)) {
+                    return true;
+                }
+            }
+            delete edge;
+            return false;
+        }
     };
 
     template<typename T>
     struct TaskNode : ITaskNode {
-        std::packaged_task<T()> task;
+        std::function<T()> func;
+        std::promise<T> promise;
         std::future<T> fut;
+        std::conditional_t<std::is_void_v<T>, bool, std::optional<T>> result{};
 
         explicit TaskNode(std::function<T()> t)
-            : task(std::move(t)), fut(task.get_future()) {}
+            : func(std::move(t)), fut(promise.get_future()) {}
 
-        void run() override { task(); }
+        void run() override {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    func();
+                } else {
+                    result.emplace(func());
+                }
+            } catch (...) {
+                recordError(std::current_exception());
+            }
+        }
+
+        void finish() override {
+            if (error) {
+                promise.set_exception(error);
+            } else if constexpr (std::is_void_v<T>) {
+                promise.set_value();
+            } else {
+                promise.set_value(std::move(*result));
+            }
+        }
     };
 
     explicit TaskGraphScheduler(ThreadPool& pool) : pool(pool) {}
@@ -38,50 +110,106 @@ public:
         std::future<T>& get_future() { return node->fut; }
     };
 
-    // Submit independent task
+    // Submit independent task. Safe to call from any thread, including running nodes.
     template<typename T>
     TaskHandle<T> submit(std::function<T()> func) {
-        auto node = std::make_shared<TaskNode<T>>(std::move(func));
-        nodes.push_back(node);
-        submitIfReady(node.get());
-        return TaskHandle<T>(node);
+        return submit_with_deps<T>(std::move(func), {});
     }
 
-    // Submit task with dependencies
+    // Submit task with dependencies. A dependency may already have completed.
     template<typename T>
     TaskHandle<T> submit_with_deps(std::function<T()> func, const std::vector<std::shared_ptr<ITaskNode>>& deps) {
-        auto node = std::make_shared<TaskNode<T>>(std::move(func));
+        return addNode<T>(std::move(func), deps, nullptr);
+    }
 
-        node->remainingDeps.store(deps.size(), std::memory_order_relaxed);
-        for (auto& dep : deps) {
-            dep->dependents.push_back(node.get());
-        }
+    // Spawn a child of the currently running node. The parent's future and its dependents are
+    // released only after the parent's body returns and every spawned child has completed, so a
+    // node can build its own subgraph in parallel and implicitly join on it without blocking.
+    template<typename T>
+    TaskHandle<T> spawn(std::function<T()> func) {
+        return spawn_with_deps<T>(std::move(func), {});
+    }
 
-        nodes.push_back(node);
-        submitIfReady(node.get());
-        return TaskHandle<T>(node);
+    template<typename T>
+    TaskHandle<T> spawn_with_deps(std::function<T()> func, const std::vector<std::shared_ptr<ITaskNode>>& deps) {
+        if (currentNode == nullptr) {
+            throw std::runtime_error("spawn must be called from inside a running task node");
+        }
+        return addNode<T>(std::move(func), deps, currentNode);
     }
 
 private:
     ThreadPool& pool;
+    std::mutex nodesMutex;
     std::vector<std::shared_ptr<ITaskNode>> nodes;
-    
-    void submitIfReady(ITaskNode* node) {
-        if (node->remainingDeps.load(std::memory_order_acquire) == 0) {
+
+    inline static thread_local ITaskNode* currentNode = nullptr;
+
+    template<typename T>
+    TaskHandle<T> addNode(std::function<T()> func, const std::vector<std::shared_ptr<ITaskNode>>& deps,
+                          ITaskNode* parent) {
+        auto node = std::make_shared<TaskNode<T>>(std::move(func));
+        node->parent = parent;
+        if (parent != nullptr) {
+            parent->pendingChildren.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(nodesMutex);
+            nodes.push_back(node);
+        }
+
+        // Hold one extra count while wiring edges so a dependency finishing mid-loop cannot
+        // schedule the node early.
+        node->remainingDeps.store(deps.size() + 1, std::memory_order_relaxed);
+        size_t finished = 1;
+        for (auto& dep : deps) {
+            if (!dep->addDependent(node.get())) {
+                ++finished;
+            }
+        }
+        releaseDeps(node.get(), finished);
+        return TaskHandle<T>(node);
+    }
+
+    void releaseDeps(ITaskNode* node, size_t count) {
+        if (node->remainingDeps.fetch_sub(count, std::memory_order_acq_rel) == count) {
             submitNode(node);
         }
     }
 
     void submitNode(ITaskNode* node) {
         pool.submit([this, node]() {
+            ITaskNode* prev = std::exchange(currentNode, node);
             node->run();
+            currentNode = prev;
+            releaseChild(node);
+        });
+    }
 
-            // Notify dependents
-            for (auto* dep : node->dependents) {
-                if (dep->remainingDeps.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-                    submitNode(dep);
-                }
+    // Drop one pending count; the last one completes the node and joins it into its parent, which
+    // inherits the child's failure so a failed subtree cannot look like a success.
+    void releaseChild(ITaskNode* node) {
+        while (node != nullptr &&
+               node->pendingChildren.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ITaskNode* parent = node->parent;
+            if (parent != nullptr && node->error) {
+                parent->recordError(node->error);
             }
-        });
+            complete(node);
+            node = parent;
+        }
+    }
+
+    void complete(ITaskNode* node) {
+        // Notify dependents
+        auto* edge = node->dependents.exchange(ITaskNode::sealed(), std::memory_order_acq_rel);
+        while (edge != nullptr) {
+            releaseDeps(edge->node, 1);
+            delete std::exchange(edge, edge->next);
+        }
+
+        // Publish last: a waiter on the root's future may tear the graph down as soon as it wakes
+        node->finish();
     }
-};
\ No newline at end of file
+};
@@ -4,13 +4,37 @@
 #include <functional>
 #include <atomic>
 #include <stdexcept>
+#include <exception>
 #include <future>
+#include <memory>
+#include <algorithm>
+#include <mutex>
+#include <chrono>
 #include "LockFreeQueue.h"  // Include your LockFreeQueue class header
+#include "TimerWheel.h"
+#if __has_include(<sys/epoll.h>)
+#include "IoReactor.h"
+#define THREADPOOL_HAS_IO 1
+#endif
 
 class ThreadPool {
 public:
     using Task = std::function<void()>;  // Define Task type as a callable
 
+    // How parallel_for hands iterations out, modelled on OpenMP's schedule clause plus TBB's
+    // auto partitioner. A chunk of 0 picks a default for the schedule.
+    enum class LoopSchedule {
+        Static,   // Equal contiguous blocks per participant, or round-robin chunks if chunk > 0
+        Dynamic,  // Participants grab the next `chunk` iterations from a shared counter
+        Guided,   // Like Dynamic, but chunks shrink with the remaining work (never below `chunk`)
+        Auto      // Whole range starts with one participant; ranges split only when someone steals
+    };
+
+    struct LoopPolicy {
+        LoopSchedule schedule = LoopSchedule::Auto;
+        size_t chunk = 0;
+    };
+
     explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency(),
                         size_t queueCapacity = 1024)
         : stopFlag(false) 
@@ -28,6 +52,7 @@ public:
         for (size_t i = 0; i < numThreads; ++i) {
             queues.emplace_back(queueCapacity); // SPSC queues
         }
+        producerLocks = std::make_unique<std::atomic<bool>[]>(numThreads);
 
         // Create and start the worker threads
         for (size_t i = 0; i < numThreads; ++i) {
@@ -52,18 +77,102 @@ public:
 
         std::future<return_type> res = task->get_future();
 
-        // Round-robin index for assigning tasks to queues
-        size_t idx = rrIndex.fetch_add(1, std::memory_order_relaxed) % queues.size();
+        enqueueTask([task]() { (*task)(); });
+        return res;
+    }
 
-        // Enqueue the task to the selected worker's queue
-        while (!queues[idx].enqueue([task]() { (*task)(); })) {
-            std::this_thread::yield();  // If the queue is full, yield the current thread
+    // Run f(i) for every i in [begin, end) and return once all iterations are done. The calling
+    // thread participates, so this is safe to call from inside a pool task. The first exception
+    // thrown by f is rethrown here; iterations not yet started are skipped.
+    template<class F>
+    void parallel_for(size_t begin, size_t end, LoopPolicy policy, F&& f) {
+        if (begin >= end) {
+            return;
         }
 
-        return res;
+        auto state = std::make_shared<LoopState<std::decay_t<F>>>(
+            begin, end, policy, workers.size() + 1, std::forward<F>(f));
+
+        for (size_t i = 0; i < workers.size(); ++i) {
+            enqueueTask([state]() { state->participate(); });
+        }
+        // Claim every participant slot no helper has reached yet: a helper queued behind the
+        // calling worker would otherwise hold its share of the range until we return
+        while (state->participate()) {
+        }
+
+        while (state->done.load(std::memory_order_acquire) < end - begin) {
+            std::this_thread::yield();
+        }
+        if (state->error) {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+    template<class F>
+    void parallel_for(size_t begin, size_t end, F&& f) {
+        parallel_for(begin, end, LoopPolicy{}, std::forward<F>(f));
+    }
+
+#ifdef THREADPOOL_HAS_IO
+    // The pool's I/O reactor, created on first use. Idle workers poll it between tasks.
+    IoReactor& io() {
+        std::call_once(reactorOnce, [this]() {
+            reactor = std::make_unique<IoReactor>();
+            reactorPtr.store(reactor.get(), std::memory_order_release);
+        });
+        return *reactor;
+    }
+
+    // Start a read and return immediately; the worker is free to run other tasks meanwhile. Once
+    // the read completes, cont(bytes read or -errno) is queued on the worker that issued it (or
+    // round-robin if issued from outside the pool). buf must stay valid until then. Once stop() has
+    // been called, continuations run directly on the worker that reaps them. Nothing waits on a
+    // continuation, so an exception it throws is discarded. On the epoll backend a pollable fd is
+    // non-blocking while operations on it are outstanding.
+    template<class F>
+    void async_read(int fd, void* buf, size_t len, off_t offset, F&& cont) {
+        io().read(fd, buf, len, offset, continuation(std::forward<F>(cont)));
+    }
+
+    template<class F>
+    void async_write(int fd, const void* buf, size_t len, off_t offset, F&& cont) {
+        io().write(fd, buf, len, offset, continuation(std::forward<F>(cont)));
+    }
+#endif
+
+    // Delayed and periodic tasks, kept on a timer wheel that idle workers service between tasks.
+    // Timers fire only as precisely as the wheel tick (1 ms) and worker availability allow; a
+    // callback runs as an ordinary task and must not throw. Timers still pending at stop() are
+    // dropped.
+    template<class F>
+    TimerWheel::Handle submit_at(TimerWheel::Clock::time_point deadline, F&& f) {
+        return timers.schedule(deadline, TimerWheel::Clock::duration::zero(), Task(std::forward<F>(f)));
+    }
+
+    template<class Rep, class Period, class F>
+    TimerWheel::Handle submit_after(std::chrono::duration<Rep, Period> delay, F&& f) {
+        return submit_at(TimerWheel::Clock::now() + std::chrono::ceil<TimerWheel::Clock::duration>(delay),
+                         std::forward<F>(f));
     }
 
-    // Stop the thread pool, wait for all threads to finish
+    // First run one period from now, then every period until cancelled
+    template<class Rep, class Period, class F>
+    TimerWheel::Handle submit_every(std::chrono::duration<Rep, Period> period, F&& f) {
+        auto p = std::chrono::ceil<TimerWheel::Clock::duration>(period);
+        if (p <= TimerWheel::Clock::duration::zero()) {
+            throw std::runtime_error("Timer period must be positive");
+        }
+        return timers.schedule(TimerWheel::Clock::now() + p, p, Task(std::forward<F>(f)));
+    }
+
+    // Returns false if the timer already fired (one-shot) or was already cancelled
+    bool cancel_timer(TimerWheel::Handle h) {
+        return timers.cancel(h);
+    }
+
+    // Stop the thread pool, wait for all threads to finish. Queued tasks still run, and any I/O
+    // they start is completed before the workers exit.
     void stop() {
         bool expected = false;
         if (!stopFlag.compare_exchange_strong(expected, true)) {
@@ -80,15 +189,267 @@ private:
     std::vector<LockFreeQueue<Task>> queues;  // SPSC queues for each worker
     std::atomic<bool> stopFlag;  // Flag to stop the pool
     std::atomic<size_t> rrIndex{0};  // Round-robin index for task distribution
+    std::unique_ptr<std::atomic<bool>[]> producerLocks;  // Serializes producers on each SPSC queue
+
+    inline static thread_local ThreadPool* currentPool = nullptr;  // Pool owning the calling worker, if any
+    inline static thread_local size_t currentWorker = 0;  // Index of the calling worker in currentPool
+
+    TimerWheel timers;
+
+    // Move due timers onto the queues. Returns true if any fired.
+    bool pollTimers(std::vector<Task>& due) {
+        if (!timers.maybeDue() || timers.poll(due) == 0) {
+            return false;
+        }
+        for (auto& t : due) {
+            enqueueTask(t);
+        }
+        due.clear();
+        return true;
+    }
+
+#ifdef THREADPOOL_HAS_IO
+    std::once_flag reactorOnce;
+    std::unique_ptr<IoReactor> reactor;
+    std::atomic<IoReactor*> reactorPtr{nullptr};  // Lets workers check for a reactor without locking
+
+    template<class F>
+    IoReactor::Completion continuation(F&& cont) {
+        size_t origin = currentPool == this ? currentWorker : queues.size();
+        return [this, origin, cont = std::forward<F>(cont)](ssize_t res) {
+            Task task = [cont, res]() {
+                try {
+                    cont(res);
+                } catch (...) {
+                    // No caller to report to; don't let it take down the worker
+                }
+            };
+            if (stopFlag.load(std::memory_order_acquire)) {
+                task();  // Shutting down: the origin worker may already have drained and exited
+            } else if (origin < queues.size()) {
+                enqueueTo(origin, task);
+            } else {
+                enqueueTask(task);
+            }
+        };
+    }
+
+    // Returns true if any completions were delivered
+    bool pollIo() {
+        IoReactor* r = reactorPtr.load(std::memory_order_acquire);
+        return r != nullptr && r->pending() != 0 && r->poll() != 0;
+    }
+#endif
+
+    // Shared bookkeeping for one parallel_for call. Participants claim an id on arrival rather
+    // than being bound to a worker, so late or never-scheduled helpers cannot stall the loop.
+    template<class F>
+    struct LoopState {
+        // Auto-partitioned range owned by one participant: the owner eats from the front and
+        // thieves split off the back half.
+        struct alignas(64) RangeSlot {
+            std::atomic<bool> lock{false};
+            size_t lo = 0;
+            size_t hi = 0;
+        };
+
+        size_t begin, end;
+        LoopPolicy policy;
+        size_t participants;
+        F f;
+
+        std::atomic<size_t> nextId{0};
+        alignas(64) std::atomic<size_t> next;
+        alignas(64) std::atomic<size_t> done{0};
+        std::unique_ptr<RangeSlot[]> slots;
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+
+        LoopState(size_t b, size_t e, LoopPolicy p, size_t n, F fn)
+            : begin(b), end(e), policy(p), participants(n), f(std::move(fn)), next(b) {
+            if (policy.schedule == LoopSchedule::Auto) {
+                slots = std::make_unique<RangeSlot[]>(participants);
+                slots[0].lo = begin;
+                slots[0].hi = end;
+            }
+        }
+
+        // Run one participant's share. Returns false once every participant id has been claimed.
+        bool participate() {
+            size_t id = nextId.fetch_add(1, std::memory_order_relaxed);
+            if (id >= participants) {
+                return false;
+            }
+
+            switch (policy.schedule) {
+                case LoopSchedule::Static:  runStatic(id); break;
+                case LoopSchedule::Dynamic: runDynamic(); break;
+                case LoopSchedule::Guided:  runGuided(); break;
+                case LoopSchedule::Auto:    runAuto(id); break;
+            }
+            return true;
+        }
+
+        void runChunk(size_t lo, size_t hi) {
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    for (size_t i = lo; i < hi; ++i) {
+                        f(i);
+                    }
+                } catch (...) {
+                    if (!failed.exchange(true)) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            done.fetch_add(hi - lo, std::memory_order_release);
+        }
+
+        void runStatic(size_t id) {
+            size_t n = end - begin;
+            if (policy.chunk == 0) {
+                size_t block = (n + participants - 1) / participants;
+                size_t lo = std::min(n, id * block);
+                size_t hi = std::min(n, lo + block);
+                if (lo < hi) {
+                    runChunk(begin + lo, begin + hi);
+                }
+                return;
+            }
+            for (size_t lo = id * policy.chunk; lo < n; lo += participants * policy.chunk) {
+                runChunk(begin + lo, begin + std::min(n, lo + policy.chunk));
+            }
+        }
+
+        void runDynamic() {
+            size_t chunk = std::max<size_t>(1, policy.chunk);
+            for (;;) {
+                size_t lo = next.fetch_add(chunk, std::memory_order_relaxed);
+                if (lo >= end) {
+                    return;
+                }
+                runChunk(lo, std::min(end, lo + chunk));
+            }
+        }
+
+        void runGuided() {
+            size_t minChunk = std::max<size_t>(1, policy.chunk);
+            size_t lo = next.load(std::memory_order_relaxed);
+            while (lo < end) {
+                size_t chunk = std::max(minChunk, (end - lo) / (2 * participants));
+                size_t hi = std::min(end, lo + chunk);
+                if (next.compare_exchange_weak(lo, hi, std::memory_order_relaxed)) {
+                    runChunk(lo, hi);
+                    lo = next.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void runAuto(size_t id) {
+            size_t grain = policy.chunk != 0
+                ? policy.chunk
+                : std::max<size_t>(1, (end - begin) / (participants * 16));
+            RangeSlot& own = slots[id];
+
+            for (;;) {
+                // Drain our own range one grain at a time
+                for (;;) {
+                    lockSlot(own);
+                    size_t lo = own.lo;
+                    size_t hi = std::min(own.hi, lo + grain);
+                    own.lo = hi;
+                    unlockSlot(own);
+                    if (lo >= hi) {
+                        break;
+                    }
+                    runChunk(lo, hi);
+                }
+
+                if (!steal(id, own)) {
+                    return;
+                }
+            }
+        }
+
+        // Split the back half off the first victim that still has work. Splitting happens only
+        // here, so a loop that nobody steals from runs as a single sequential range.
+        bool steal(size_t id, RangeSlot& own) {
+            for (size_t k = 1; k < participants; ++k) {
+                RangeSlot& victim = slots[(id + k) % participants];
+                lockSlot(victim);
+                size_t remaining = victim.hi - victim.lo;
+                if (remaining == 0) {
+                    unlockSlot(victim);
+                    continue;
+                }
+                size_t mid = victim.hi - (remaining + 1) / 2;
+                size_t hi = victim.hi;
+                victim.hi = mid;
+                unlockSlot(victim);
+
+                lockSlot(own);
+                own.lo = mid;
+                own.hi = hi;
+                unlockSlot(own);
+                return true;
+            }
+            return false;
+        }
+
+        static void lockSlot(RangeSlot& slot) {
+            while (slot.lock.exchange(true, std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+
+        static void unlockSlot(RangeSlot& slot) {
+            slot.lock.store(false, std::memory_order_release);
+        }
+    };
+
+    // Enqueue a task round-robin. Workers may submit too (e.g. graph nodes spawning children), so
+    // producers take the queue's lock to keep each queue single-producer.
+    void enqueueTask(const Task& task) {
+        enqueueTo(rrIndex.fetch_add(1, std::memory_order_relaxed) % queues.size(), task);
+    }
+
+    void enqueueTo(size_t idx, const Task& task) {
+        while (!tryEnqueue(idx, task)) {
+            if (currentPool == this) {
+                // A worker spinning on a full queue may be the one that has to drain it: run inline
+                task();
+                return;
+            }
+            std::this_thread::yield();  // If the queue is full, yield the current thread
+        }
+    }
+
+    bool tryEnqueue(size_t idx, const Task& task) {
+        auto& lock = producerLocks[idx];
+        while (lock.exchange(true, std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        bool ok = queues[idx].enqueue(task);
+        lock.store(false, std::memory_order_release);
+        return ok;
+    }
 
     // Worker thread loop: processes tasks from its respective queue
     void workerLoop(size_t i) {
         auto& q = queues[i];  // Get the specific queue for the worker
+        currentPool = this;
+        currentWorker = i;
         Task task;
+        std::vector<Task> dueTimers;
         while (!stopFlag.load(std::memory_order_acquire)) {
             if (q.dequeue(task)) {
-                std::cout << "Executing a task\n";
                 task();  // Execute the task
+#ifdef THREADPOOL_HAS_IO
+            } else if (pollIo()) {
+                continue;  // Completed I/O queued continuations
+#endif
+            } else if (pollTimers(dueTimers)) {
+                continue;  // Due timers were queued
             } else {
                 // Queue empty → yield to avoid busy-waiting
                 std::this_thread::yield();
@@ -96,8 +457,24 @@ private:
         }
 
         // Drain remaining tasks if any
-        while (q.dequeue(task)) {
-            task();
+        for (;;) {
+            if (q.dequeue(task)) {
+                task();
+                continue;
+            }
+#ifdef THREADPOOL_HAS_IO
+            // Drained tasks may have started I/O; the reactor must be idle before it is destroyed
+            IoReactor* r = reactorPtr.load(std::memory_order_acquire);
+            if (r != nullptr && r->pending() != 0) {
+                if (!pollIo()) {
+                    std::this_thread::yield();
+                }
+                continue;
+            }
+#endif
+            if (q.empty()) {
+                break;
+            }
         }
     }
 };
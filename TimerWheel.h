@@ -0,0 +1,254 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Hierarchical timing wheel (Varghese & Lauck, as used by the Linux kernel's timer lists). Four
+// levels of 256 slots each cover 2^32 ticks; a timer sits in the coarsest level that spans its
+// delay and cascades down to finer levels as its deadline approaches. Timers are intrusive nodes
+// in per-slot doubly-linked lists, so insert and cancel are O(1). Timers further out than the
+// wheel spans park in the top level and are re-filed whenever that slot cascades.
+//
+// The wheel is thread-safe. Any thread may schedule or cancel; whoever calls poll() collects the
+// callbacks that are due (concurrent pollers simply back off).
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+
+    // Identifies a scheduled timer. Stays valid across the re-arms of a periodic timer; the
+    // generation makes stale handles (fired or cancelled timers whose slot was reused) harmless.
+    struct Handle {
+        uint32_t index = NIL;
+        uint32_t generation = 0;
+    };
+
+    explicit TimerWheel(Clock::duration tick = std::chrono::milliseconds(1))
+        : tickLength(tick), start(Clock::now()) {
+        for (auto& level : slots) {
+            level.fill(NIL);
+        }
+    }
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    // Run cb at (or just after) the deadline; a non-zero period re-arms it every period after that
+    Handle schedule(Clock::time_point deadline, Clock::duration period, Callback cb) {
+        std::lock_guard<std::mutex> lock(mutex);
+        uint32_t i = allocate();
+        Node& n = nodes[i];
+        n.expires = toTick(deadline);
+        n.period = period.count() > 0 ? std::max<uint64_t>(1, ceilTicks(period)) : 0;
+        n.callback = std::move(cb);
+        n.armed = true;
+        if (pendingCount.load(std::memory_order_relaxed) == 0) {
+            // Pollers skip an empty wheel, so the tick may be stale: catch up before filing against it
+            uint64_t now = std::max(currentTick.load(std::memory_order_relaxed), nowTick(Clock::now()));
+            currentTick.store(now, std::memory_order_release);
+        }
+        insert(i);
+        pendingCount.fetch_add(1, std::memory_order_release);
+        return Handle{i, n.generation};
+    }
+
+    // Returns false if the timer already fired (one-shot) or was cancelled
+    bool cancel(Handle h) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (h.index >= nodes.size() || nodes[h.index].generation != h.generation || !nodes[h.index].armed) {
+            return false;
+        }
+        unlink(h.index);
+        release(h.index);
+        pendingCount.fetch_sub(1, std::memory_order_release);
+        return true;
+    }
+
+    // Number of armed timers (periodic timers count once)
+    size_t pending() const { return pendingCount.load(std::memory_order_acquire); }
+
+    // Cheap lock-free check for pollers: is anything armed and has a tick elapsed since last poll?
+    bool maybeDue(Clock::time_point now = Clock::now()) const {
+        return pending() != 0 && nowTick(now) > currentTick.load(std::memory_order_acquire);
+    }
+
+    // Advance the wheel to `now` and append every due callback to `due`. Returns the number added,
+    // or 0 without waiting if another thread is already polling.
+    size_t poll(std::vector<Callback>& due, Clock::time_point now = Clock::now()) {
+        std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+        if (!lock.owns_lock()) {
+            return 0;
+        }
+
+        size_t before = due.size();
+        uint64_t target = nowTick(now);
+        uint64_t tick = currentTick.load(std::memory_order_relaxed);
+
+        collect(overdue, due, target);
+        while (tick < target) {
+            if (pendingCount.load(std::memory_order_relaxed) == 0) {
+                tick = target;  // Nothing to cascade or fire: skip the idle stretch
+                break;
+            }
+            ++tick;
+            currentTick.store(tick, std::memory_order_release);
+
+            // Pull coarser levels down when the finer level wraps around
+            for (int level = 1; level < LEVELS && slotIndex(tick, level - 1) == 0; ++level) {
+                cascade(level, slotIndex(tick, level));
+            }
+            collect(overdue, due, target);  // Timers that cascaded down on their own expiry tick
+            collect(slots[0][slotIndex(tick, 0)], due, target);
+        }
+        currentTick.store(tick, std::memory_order_release);
+        return due.size() - before;
+    }
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 8;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;
+    static constexpr uint32_t NIL = UINT32_MAX;
+    static constexpr uint64_t MAX_DELAY = (uint64_t{1} << (LEVELS * SLOT_BITS)) - 1;
+
+    struct Node {
+        uint64_t expires = 0;   // Absolute tick
+        uint64_t period = 0;    // Ticks between runs, 0 for one-shot
+        Callback callback;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;    // Doubles as the free-list link
+        uint32_t* head = nullptr;  // Slot list this node is on
+        uint32_t generation = 0;
+        bool armed = false;
+    };
+
+    Clock::duration tickLength;
+    Clock::time_point start;
+    std::mutex mutex;
+    std::vector<Node> nodes;
+    uint32_t freeList = NIL;
+    std::array<std::array<uint32_t, SLOTS>, LEVELS> slots;
+    uint32_t overdue = NIL;  // Timers scheduled at or before the current tick
+    std::atomic<uint64_t> currentTick{0};
+    std::atomic<size_t> pendingCount{0};
+
+    static uint32_t slotIndex(uint64_t tick, int level) {
+        return static_cast<uint32_t>(tick >> (level * SLOT_BITS)) & (SLOTS - 1);
+    }
+
+    uint64_t ceilTicks(Clock::duration d) const {
+        return static_cast<uint64_t>((d + tickLength - Clock::duration(1)) / tickLength);
+    }
+
+    uint64_t toTick(Clock::time_point tp) const {
+        return tp <= start ? 0 : ceilTicks(tp - start);
+    }
+
+    uint64_t nowTick(Clock::time_point now) const {
+        return now <= start ? 0 : static_cast<uint64_t>((now - start) / tickLength);
+    }
+
+    uint32_t allocate() {
+        if (freeList != NIL) {
+            uint32_t i = freeList;
+            freeList = nodes[i].next;
+            return i;
+        }
+        nodes.emplace_back();
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    void release(uint32_t i) {
+        Node& n = nodes[i];
+        n.callback = nullptr;
+        n.armed = false;
+        ++n.generation;
+        n.next = freeList;
+        freeList = i;
+    }
+
+    // File a node under the slot matching its distance from the current tick
+    void insert(uint32_t i) {
+        uint64_t now = currentTick.load(std::memory_order_relaxed);
+        uint64_t expires = nodes[i].expires;
+        uint32_t* head;
+        if (expires <= now) {
+            head = &overdue;
+        } else {
+            uint64_t delay = expires - now;
+            if (delay > MAX_DELAY) {
+                expires = now + MAX_DELAY;  // Re-filed from the top level until it is in range
+            }
+            int level = 0;
+            while (level < LEVELS - 1 && delay >= (uint64_t{1} << ((level + 1) * SLOT_BITS))) {
+                ++level;
+            }
+            head = &slots[level][slotIndex(expires, level)];
+        }
+        link(i, head);
+    }
+
+    void link(uint32_t i, uint32_t* head) {
+        Node& n = nodes[i];
+        n.head = head;
+        n.prev = NIL;
+        n.next = *head;
+        if (*head != NIL) {
+            nodes[*head].prev = i;
+        }
+        *head = i;
+    }
+
+    void unlink(uint32_t i) {
+        Node& n = nodes[i];
+        if (n.prev != NIL) {
+            nodes[n.prev].next = n.next;
+        } else {
+            *n.head = n.next;
+        }
+        if (n.next != NIL) {
+            nodes[n.next].prev = n.prev;
+        }
+        n.prev = n.next = NIL;
+        n.head = nullptr;
+    }
+
+    void cascade(int level, uint32_t slot) {
+        uint32_t i = std::exchange(slots[level][slot], NIL);
+        while (i != NIL) {
+            uint32_t next = nodes[i].next;
+            insert(i);
+            i = next;
+        }
+    }
+
+    // Hand out every callback on the list. One-shot timers are freed, periodic ones re-armed at
+    // their next deadline after `horizon`, the tick this poll advances to, so a late poll skips
+    // missed periods instead of replaying them.
+    void collect(uint32_t& head, std::vector<Callback>& due, uint64_t horizon) {
+        uint32_t i = std::exchange(head, NIL);
+        while (i != NIL) {
+            Node& n = nodes[i];
+            uint32_t next = n.next;
+            if (n.period == 0) {
+                due.push_back(std::move(n.callback));
+                release(i);
+                pendingCount.fetch_sub(1, std::memory_order_release);
+            } else {
+                due.push_back(n.callback);
+                n.expires += n.period;
+                if (n.expires <= horizon) {
+                    n.expires += ((horizon - n.expires) / n.period + 1) * n.period;
+                }
+                insert(i);
+            }
+            i = next;
+        }
+    }
+};
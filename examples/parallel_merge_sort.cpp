@@ -17,28 +17,24 @@ void merge(std::vector<int>& arr, int l, int mid, int r) {
     std::copy(temp.begin(), temp.end(), arr.begin() + l);
 }
 
-// Recursive parallel merge sort
-TaskGraphScheduler::TaskHandle<void> merge_sort(
-    std::vector<int>& arr, int l, int r,
-    TaskGraphScheduler& sched, int cutoff = 16
-) {
+// Recursive parallel merge sort: each node spawns its halves and the merge that joins them,
+// so the graph is built in parallel by the workers instead of serially on the main thread.
+void merge_sort(std::vector<int>& arr, int l, int r, TaskGraphScheduler& sched, int cutoff = 16) {
     if (r - l <= cutoff) {
-        return sched.submit<void>([&arr, l, r] {
-            std::sort(arr.begin() + l, arr.begin() + r);
-        });
-    } else {
-        int mid = l + (r - l) / 2;
+        std::sort(arr.begin() + l, arr.begin() + r);
+        return;
+    }
 
-        // Recursively spawn left and right tasks
-        auto left  = merge_sort(arr, l, mid, sched, cutoff);
-        auto right = merge_sort(arr, mid, r, sched, cutoff);
+    int mid = l + (r - l) / 2;
 
-        // Merge task depends on left and right
-        return sched.submit_with_deps<void>(
-            [&arr, l, mid, r] { merge(arr, l, mid, r); },
-            std::vector<std::shared_ptr<TaskGraphScheduler::ITaskNode>>{ left.node, right.node }
-        );
-    }
+    auto left  = sched.spawn<void>([&arr, l, mid, &sched, cutoff] { merge_sort(arr, l, mid, sched, cutoff); });
+    auto right = sched.spawn<void>([&arr, mid, r, &sched, cutoff] { merge_sort(arr, mid, r, sched, cutoff); });
+
+    // Merge task depends on left and right, which only complete once their own subgraphs have
+    sched.spawn_with_deps<void>(
+        [&arr, l, mid, r] { merge(arr, l, mid, r); },
+        std::vector<std::shared_ptr<TaskGraphScheduler::ITaskNode>>{ left.node, right.node }
+    );
 }
 
 int main() {
@@ -55,7 +51,7 @@ int main() {
     TaskGraphScheduler sched(pool);
 
     // Run parallel merge sort
-    auto rootTask = merge_sort(data, 0, data.size(), sched);
+    auto rootTask = sched.submit<void>([&data, &sched] { merge_sort(data, 0, data.size(), sched); });
     rootTask.get_future().get();  // wait for completion
 
     // Verify sorted
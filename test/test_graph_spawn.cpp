@@ -0,0 +1,120 @@
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+#include <string>
+#include "../TaskScheduler.h"
+
+using Deps = std::vector<std::shared_ptr<TaskGraphScheduler::ITaskNode>>;
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    std::cout << (ok ? "ok    " : "FAIL  ") << what << "\n";
+    if (!ok) ++failures;
+}
+
+// Build a binary tree of nodes from inside the graph: every node spawns its halves plus a join
+// that depends on both, so the whole graph is created in parallel by the workers.
+void spawnTree(TaskGraphScheduler& sched, size_t lo, size_t hi,
+               std::atomic<size_t>& leaves, std::atomic<size_t>& joins) {
+    if (hi - lo == 1) {
+        leaves.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    auto left  = sched.spawn<void>([&, lo, mid] { spawnTree(sched, lo, mid, leaves, joins); });
+    auto right = sched.spawn<void>([&, mid, hi] { spawnTree(sched, mid, hi, leaves, joins); });
+    sched.spawn_with_deps<void>([&] { joins.fetch_add(1, std::memory_order_relaxed); },
+                                Deps{ left.node, right.node });
+}
+
+int main() {
+    ThreadPool pool(4);
+    TaskGraphScheduler sched(pool);
+
+    // Subgraph spawned from inside nodes: the root completes only after every descendant
+    {
+        constexpr size_t N = 1 << 14;
+        std::atomic<size_t> leaves{0}, joins{0};
+        auto start = std::chrono::high_resolution_clock::now();
+        auto root = sched.submit<size_t>([&] {
+            spawnTree(sched, 0, N, leaves, joins);
+            return N;
+        });
+        size_t r = root.get_future().get();
+        auto end = std::chrono::high_resolution_clock::now();
+        check(r == N && leaves.load() == N && joins.load() == N - 1, "spawned tree joins into its root");
+        std::cout << "      " << 3 * N - 2 << " nodes in "
+                  << std::chrono::duration<double>(end - start).count() << " s\n";
+    }
+
+    // Dependency on a node that already finished
+    {
+        auto a = sched.submit<int>([] { return 20; });
+        a.get_future().wait();
+        auto b = sched.submit_with_deps<int>([] { return 22; }, Deps{ a.node });
+        check(b.get_future().get() == 22, "submit_with_deps on a finished dependency");
+    }
+
+    // Dependents attached from several threads while the dependency is completing
+    {
+        constexpr int ROUNDS = 2000;
+        constexpr int ATTACHERS = 4;
+        std::atomic<int> ran{0};
+        bool allReady = true;
+        for (int round = 0; round < ROUNDS; ++round) {
+            auto dep = sched.submit<int>([] { return 1; });
+            std::vector<std::thread> attachers;
+            std::vector<TaskGraphScheduler::TaskHandle<void>> handles[ATTACHERS];
+            for (int t = 0; t < ATTACHERS; ++t) {
+                attachers.emplace_back([&, t] {
+                    for (int k = 0; k < 4; ++k) {
+                        handles[t].push_back(sched.submit_with_deps<void>(
+                            [&] { ran.fetch_add(1, std::memory_order_relaxed); }, Deps{ dep.node }));
+                    }
+                });
+            }
+            for (auto& th : attachers) th.join();
+            for (auto& hs : handles) {
+                for (auto& h : hs) {
+                    allReady &= h.get_future().wait_for(std::chrono::seconds(5)) == std::future_status::ready;
+                }
+            }
+        }
+        check(allReady && ran.load() == ROUNDS * ATTACHERS * 4, "dependents attached while the dependency completes");
+    }
+
+    // A failing child fails its parent
+    {
+        auto root = sched.submit<int>([&] {
+            sched.spawn<void>([&] {
+                sched.spawn<void>([] { throw std::runtime_error("leaf failed"); });
+            });
+            return 1;
+        });
+        bool threw = false;
+        try {
+            root.get_future().get();
+        } catch (const std::runtime_error& e) {
+            threw = std::string(e.what()) == "leaf failed";
+        }
+        check(threw, "child exception propagates to the root");
+    }
+
+    // spawn is only valid inside a running node
+    {
+        bool threw = false;
+        try {
+            sched.spawn<void>([] {});
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        check(threw, "spawn outside a node throws");
+    }
+
+    pool.stop();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <string>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <unistd.h>
+#include <fcntl.h>
+#include "../ThreadPool.h"
+
+// Reads a local file in chunks through the pool's reactor and checks the contents, then pushes
+// data through a pipe whose reader is posted before the writer, so a blocking read would stall.
+int main() {
+    constexpr size_t CHUNK = 4096;
+    constexpr size_t NUM_CHUNKS = 4096;  // 16 MiB file
+
+    char path[] = "/tmp/threadpool_io_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        std::cerr << "mkstemp failed\n";
+        return 1;
+    }
+    unlink(path);
+
+    std::vector<char> data(CHUNK * NUM_CHUNKS);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 131 % 251);
+    }
+    if (write(fd, data.data(), data.size()) != static_cast<ssize_t>(data.size())) {
+        std::cerr << "write failed\n";
+        return 1;
+    }
+
+    ThreadPool pool;
+    std::cout << "Backend: " << (pool.io().backend() == IoReactor::Backend::IoUring ? "io_uring" : "epoll") << "\n";
+
+    // File reads, issued from inside pool tasks
+    std::vector<char> out(data.size());
+    std::atomic<size_t> completed{0};
+    std::atomic<size_t> bad{0};
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t c = 0; c < NUM_CHUNKS; ++c) {
+        pool.submit([&, c]() {
+            pool.async_read(fd, out.data() + c * CHUNK, CHUNK, static_cast<off_t>(c * CHUNK),
+                            [&](ssize_t n) {
+                                if (n != static_cast<ssize_t>(CHUNK)) ++bad;
+                                completed.fetch_add(1, std::memory_order_release);
+                            });
+        });
+    }
+    while (completed.load(std::memory_order_acquire) < NUM_CHUNKS) {
+        std::this_thread::yield();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    double elapsed = std::chrono::duration<double>(end - start).count();
+
+    std::cout << "File: " << NUM_CHUNKS << " reads of " << CHUNK << " bytes in " << elapsed << " s ("
+              << data.size() / elapsed / (1 << 20) << " MiB/s)"
+              << (bad.load() == 0 && out == data ? "" : "  MISMATCH") << "\n";
+    close(fd);
+
+    // Pipe: the read is posted first and must not block its worker while the write is pending
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::cerr << "pipe failed\n";
+        return 1;
+    }
+    const std::string message = "hello through the reactor";
+    std::string received(message.size(), '\0');
+    std::atomic<bool> readDone{false};
+    std::atomic<bool> writeDone{false};
+
+    pool.submit([&]() {
+        pool.async_read(fds[0], received.data(), received.size(), -1, [&](ssize_t n) {
+            if (n != static_cast<ssize_t>(message.size())) ++bad;
+            readDone.store(true, std::memory_order_release);
+        });
+    });
+    pool.submit([&]() {
+        pool.async_write(fds[1], message.data(), message.size(), -1, [&](ssize_t n) {
+            if (n != static_cast<ssize_t>(message.size())) ++bad;
+            writeDone.store(true, std::memory_order_release);
+        });
+    });
+    while (!readDone.load(std::memory_order_acquire) || !writeDone.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    std::cout << "Pipe: " << (bad.load() == 0 && received == message ? "ok" : "MISMATCH") << "\n";
+
+    // Same pipe round trip on the epoll fallback, polled by hand
+    IoReactor fallback(IoReactor::Backend::Epoll);
+    std::string echoed(message.size(), '\0');
+    ssize_t readResult = 0;
+    fallback.read(fds[0], echoed.data(), echoed.size(), -1, [&](ssize_t n) { readResult = n; });
+    fallback.poll();
+    bool idleBeforeWrite = fallback.pending() == 1;
+    fallback.write(fds[1], message.data(), message.size(), -1, [](ssize_t) {});
+    while (fallback.pending() != 0) {
+        fallback.poll();
+    }
+    std::cout << "Epoll fallback: "
+              << (idleBeforeWrite && readResult == static_cast<ssize_t>(message.size()) && echoed == message
+                      ? "ok" : "MISMATCH") << "\n";
+
+    // A write far larger than the pipe buffer must not block the poller: it reports a partial count
+    std::vector<char> big(1 << 20, 'x');
+    ssize_t bigResult = 0;
+    fallback.write(fds[1], big.data(), big.size(), -1, [&](ssize_t n) { bigResult = n; });
+    auto pollStart = std::chrono::high_resolution_clock::now();
+    while (fallback.pending() != 0) {
+        fallback.poll();
+    }
+    double pollMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - pollStart).count();
+    std::cout << "Epoll large write: " << bigResult << " of " << big.size() << " bytes in " << pollMs << " ms"
+              << (bigResult > 0 && bigResult < static_cast<ssize_t>(big.size()) ? "" : "  MISMATCH") << "\n";
+    std::cout << "Epoll restores blocking mode: "
+              << ((fcntl(fds[1], F_GETFL) & O_NONBLOCK) == 0 ? "ok" : "MISMATCH") << "\n";
+
+    // A bad descriptor is reported through the completion on both backends and leaves nothing pending
+    for (auto backend : {IoReactor::Backend::IoUring, IoReactor::Backend::Epoll}) {
+        IoReactor reactor(backend);
+        char byte;
+        ssize_t badResult = 0;
+        reactor.read(-1, &byte, 1, -1, [&](ssize_t n) { badResult = n; });
+        while (reactor.pending() != 0) {
+            reactor.poll();
+        }
+        std::cout << "Bad fd (" << (reactor.backend() == IoReactor::Backend::IoUring ? "io_uring" : "epoll")
+                  << "): " << (badResult == -EBADF ? "ok" : "MISMATCH") << "\n";
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+    pool.stop();
+
+    // A throwing continuation is dropped instead of terminating the worker
+    {
+        ThreadPool throwing(2);
+        std::atomic<bool> after{false};
+        char byte;
+        int file = open("/proc/self/exe", O_RDONLY);
+        throwing.async_read(file, &byte, 1, 0, [](ssize_t) { throw std::runtime_error("continuation"); });
+        throwing.async_read(file, &byte, 1, 0, [&](ssize_t) { after = true; });
+        while (!after.load()) {
+            std::this_thread::yield();
+        }
+        throwing.stop();
+        close(file);
+        std::cout << "Throwing continuation: ok\n";
+    }
+
+    // I/O started by tasks still queued at stop() completes before the workers exit
+    {
+        int file = open("/proc/self/exe", O_RDONLY);
+        std::vector<char> chunk(CHUNK);
+        std::atomic<size_t> reads{0};
+        std::function<void(off_t)> readFrom;
+        ThreadPool stopping(2);
+        readFrom = [&](off_t off) {
+            stopping.async_read(file, chunk.data(), chunk.size(), off, [&, off](ssize_t n) {
+                if (reads.fetch_add(1) + 1 < 8 && n > 0) readFrom(off + n);  // Chain from the continuation
+            });
+        };
+        stopping.submit([&]() { readFrom(0); });
+        stopping.stop();
+        std::cout << "Stop with queued I/O: " << reads.load() << " chained reads, reactor pending "
+                  << stopping.io().pending() << (reads.load() == 8 && stopping.io().pending() == 0 ? "" : "  MISMATCH")
+                  << "\n";
+        close(file);
+    }
+    return 0;
+}
@@ -0,0 +1,81 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <atomic>
+#include "../ThreadPool.h"
+
+double heavyComputation(int n) {
+    double sum = 0.0;
+    for (int i = 1; i < n; ++i) {
+        sum += std::sin(i) * std::cos(i / 2.0);
+    }
+    return sum;
+}
+
+// Uniform: every iteration costs the same
+int uniformCost(size_t) { return 20000; }
+
+// Skewed: cost grows with the index and every 64th iteration is a spike
+int skewedCost(size_t i) { return static_cast<int>(1000 + i * 8 + (i % 64 == 0 ? 400000 : 0)); }
+
+template<class Cost>
+double runLoop(ThreadPool& pool, ThreadPool::LoopPolicy policy, size_t n, Cost cost, std::vector<double>& out) {
+    auto start = std::chrono::high_resolution_clock::now();
+    pool.parallel_for(0, n, policy, [&](size_t i) {
+        out[i] = heavyComputation(cost(i));
+    });
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+template<class Cost>
+void benchmark(const char* name, ThreadPool& pool, size_t n, Cost cost) {
+    std::vector<double> expected(n);
+    auto seqStart = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < n; ++i) {
+        expected[i] = heavyComputation(cost(i));
+    }
+    auto seqEnd = std::chrono::high_resolution_clock::now();
+    double seq = std::chrono::duration<double>(seqEnd - seqStart).count();
+
+    std::cout << name << " (" << n << " iterations), sequential: " << seq << " s\n";
+
+    struct Case { const char* label; ThreadPool::LoopPolicy policy; };
+    const Case cases[] = {
+        {"static",        {ThreadPool::LoopSchedule::Static, 0}},
+        {"static,16",     {ThreadPool::LoopSchedule::Static, 16}},
+        {"dynamic,1",     {ThreadPool::LoopSchedule::Dynamic, 1}},
+        {"dynamic,16",    {ThreadPool::LoopSchedule::Dynamic, 16}},
+        {"guided",        {ThreadPool::LoopSchedule::Guided, 0}},
+        {"auto",          {ThreadPool::LoopSchedule::Auto, 0}},
+    };
+
+    for (const auto& c : cases) {
+        std::vector<double> out(n);
+        double t = runLoop(pool, c.policy, n, cost, out);
+        std::cout << "  " << c.label << ": " << t << " s, speedup " << seq / t << "x"
+                  << (out == expected ? "" : "  MISMATCH") << "\n";
+    }
+}
+
+int main() {
+    ThreadPool pool;
+
+    benchmark("Uniform cost", pool, 4000, uniformCost);
+    benchmark("Skewed cost", pool, 4000, skewedCost);
+
+    // Overhead check: a trivial body with many iterations
+    constexpr size_t N = 10'000'000;
+    std::atomic<size_t> sum{0};
+    auto start = std::chrono::high_resolution_clock::now();
+    pool.parallel_for(0, N, [&](size_t i) {
+        if (i % 1024 == 0) sum.fetch_add(1, std::memory_order_relaxed);
+    });
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "Trivial body, auto: " << std::chrono::duration<double>(end - start).count()
+              << " s (" << (sum.load() == (N + 1023) / 1024 ? "ok" : "MISMATCH") << ")\n";
+
+    pool.stop();
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <cmath>
+#include <stdexcept>
+#include "../Pipeline.h"
+
+// One record flowing through parse -> transform -> aggregate
+struct Record {
+    std::string line;
+    long key = 0;
+    double value = 0.0;
+};
+
+int main() {
+    constexpr size_t NUM_ITEMS = 2'000'000;
+    ThreadPool pool;
+
+    int failures = 0;
+
+    // {tokens, batch size, add a serial-out-of-order stage}
+    const size_t configs[][3] = { {4, 16, 0}, {16, 64, 0}, {64, 256, 0}, {16, 64, 1} };
+
+    for (const auto& cfg : configs) {
+        size_t produced = 0;
+        size_t expectedKey = 0;
+        size_t unorderedCount = 0;
+        size_t unorderedKeys = 0;
+        bool inOrder = true;
+        double total = 0.0;
+
+        Pipeline<Record> pipeline(pool, cfg[0], cfg[1]);
+        pipeline
+            .source([&](Record& r) {
+                if (produced == NUM_ITEMS) return false;
+                r.line = std::to_string(produced) + "," + std::to_string(produced % 1000);
+                ++produced;
+                return true;
+            })
+            .stage(StageMode::Parallel, [](Record& r) {  // parse
+                auto comma = r.line.find(',');
+                r.key = std::stol(r.line.substr(0, comma));
+                r.value = std::stod(r.line.substr(comma + 1));
+            })
+            .stage(StageMode::Parallel, [](Record& r) {  // transform
+                r.value = std::sqrt(r.value) * std::log1p(r.value);
+            });
+        if (cfg[2]) {
+            pipeline.stage(StageMode::SerialOutOfOrder, [&](Record& r) {  // audit, any order
+                ++unorderedCount;
+                unorderedKeys += static_cast<size_t>(r.key);
+            });
+        }
+        pipeline.stage(StageMode::SerialInOrder, [&](Record& r) {  // aggregate
+            inOrder &= static_cast<size_t>(r.key) == expectedKey++;
+            total += r.value;
+        });
+
+        // The out-of-order configuration also runs twice to check the pipeline can be re-run
+        for (size_t pass = 0; pass < (cfg[2] ? 2 : 1); ++pass) {
+            produced = expectedKey = unorderedCount = unorderedKeys = 0;
+            inOrder = true;
+            total = 0.0;
+
+            auto start = std::chrono::high_resolution_clock::now();
+            pipeline.run();
+            auto end = std::chrono::high_resolution_clock::now();
+            double elapsed = std::chrono::duration<double>(end - start).count();
+
+            bool ok = inOrder && expectedKey == NUM_ITEMS;
+            if (cfg[2]) {
+                ok &= unorderedCount == NUM_ITEMS && unorderedKeys == NUM_ITEMS * (NUM_ITEMS - 1) / 2;
+            }
+            failures += !ok;
+
+            std::cout << "tokens=" << cfg[0] << " batch=" << cfg[1]
+                      << (cfg[2] ? " +out-of-order" : "") << (pass ? " (re-run)" : "")
+                      << ": " << NUM_ITEMS / elapsed / 1e6 << " M items/sec"
+                      << (ok ? "" : "  MISMATCH")
+                      << " (total " << total << ")\n";
+        }
+    }
+
+    // A throwing stage stops the source and run() rethrows
+    {
+        size_t produced = 0;
+        Pipeline<Record> pipeline(pool, 8, 32);
+        pipeline
+            .source([&](Record& r) {
+                if (produced == NUM_ITEMS) return false;
+                r.key = static_cast<long>(produced++);
+                return true;
+            })
+            .stage(StageMode::Parallel, [](Record& r) {
+                if (r.key == 1000) throw std::runtime_error("bad record");
+            })
+            .stage(StageMode::SerialInOrder, [](Record&) {});
+
+        bool threw = false;
+        try {
+            pipeline.run();
+        } catch (const std::runtime_error& e) {
+            threw = std::string(e.what()) == "bad record";
+        }
+        bool ok = threw && produced < NUM_ITEMS;
+        failures += !ok;
+        std::cout << "Throwing stage: " << (ok ? "rethrown, source stopped" : "MISMATCH") << "\n";
+    }
+
+    pool.stop();
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,95 @@
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <atomic>
+#include <random>
+#include <algorithm>
+#include "../ThreadPool.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main() {
+    ThreadPool pool;
+
+    // Accuracy: how late do one-shot timers fire relative to their deadline?
+    {
+        constexpr size_t NUM_TIMERS = 2000;
+        std::vector<double> lateness(NUM_TIMERS);
+        std::atomic<size_t> fired{0};
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> delayMs(1, 200);
+
+        for (size_t i = 0; i < NUM_TIMERS; ++i) {
+            auto deadline = Clock::now() + std::chrono::milliseconds(delayMs(rng));
+            pool.submit_at(deadline, [&, i, deadline]() {
+                lateness[i] = std::chrono::duration<double, std::micro>(Clock::now() - deadline).count();
+                fired.fetch_add(1, std::memory_order_release);
+            });
+        }
+        while (fired.load(std::memory_order_acquire) < NUM_TIMERS) {
+            std::this_thread::yield();
+        }
+
+        std::sort(lateness.begin(), lateness.end());
+        double mean = 0.0;
+        for (double l : lateness) mean += l;
+        mean /= NUM_TIMERS;
+        std::cout << "Accuracy (" << NUM_TIMERS << " timers, 1-200 ms): mean " << mean << " us, p50 "
+                  << lateness[NUM_TIMERS / 2] << " us, p99 " << lateness[NUM_TIMERS * 99 / 100]
+                  << " us, max " << lateness.back() << " us"
+                  << (lateness.front() >= 0.0 ? "" : "  FIRED EARLY") << "\n";
+    }
+
+    // Throughput: 1M pending timers, cancel half, let the rest fire
+    {
+        constexpr size_t NUM_TIMERS = 1'000'000;
+        std::vector<TimerWheel::Handle> handles(NUM_TIMERS);
+        std::atomic<size_t> fired{0};
+        std::mt19937 rng(7);
+        std::uniform_int_distribution<int> delayUs(1'000'000, 2'500'000);
+
+        auto start = Clock::now();
+        for (size_t i = 0; i < NUM_TIMERS; ++i) {
+            handles[i] = pool.submit_after(std::chrono::microseconds(delayUs(rng)), [&fired]() {
+                fired.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        auto inserted = Clock::now();
+
+        size_t cancelled = 0;
+        for (size_t i = 0; i < NUM_TIMERS; i += 2) {
+            cancelled += pool.cancel_timer(handles[i]);
+        }
+        auto cancelEnd = Clock::now();
+
+        while (fired.load(std::memory_order_relaxed) < NUM_TIMERS - cancelled) {
+            std::this_thread::yield();
+        }
+        auto end = Clock::now();
+
+        double insertSec = std::chrono::duration<double>(inserted - start).count();
+        double cancelSec = std::chrono::duration<double>(cancelEnd - inserted).count();
+        std::cout << "1M timers: insert " << NUM_TIMERS / insertSec / 1e6 << " M/sec, cancel "
+                  << cancelled / cancelSec / 1e6 << " M/sec (" << cancelled << " cancelled), " << fired.load() << " fired in "
+                  << std::chrono::duration<double>(end - start).count() << " s"
+                  << (fired.load() == NUM_TIMERS - cancelled ? "" : "  MISMATCH")
+                  << "\n";
+    }
+
+    // Periodic: a 5 ms timer over half a second, without drift
+    {
+        std::atomic<size_t> runs{0};
+        auto start = Clock::now();
+        auto handle = pool.submit_every(std::chrono::milliseconds(5), [&runs]() {
+            runs.fetch_add(1, std::memory_order_relaxed);
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(502));
+        pool.cancel_timer(handle);
+        double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::cout << "Periodic 5 ms: " << runs.load() << " runs in " << elapsed << " ms (expected ~"
+                  << static_cast<size_t>(elapsed / 5) << ")\n";
+    }
+
+    pool.stop();
+    return 0;
+}